@@ -0,0 +1,523 @@
+/* Definitions for functions declared in Combo.h
+ *
+ * The combos are compiled into one Aho-Corasick automaton. Every state has a transition for every
+ * input symbol, so each input is a single table lookup. A state that ends a combo links to the next
+ * shorter combo that also ends there, and that chain is no longer than COMBO_MAX_LENGTH, so the work
+ * per input does not depend on how many combos are loaded
+ *
+ * Project Name: SDL_Game_Input
+ * Author:       Jake Moses
+ *
+ * Purpose: This project is meant to test gamepad input using the SDL
+ * suite. Parts of this may be used to ignore XInput for DirectX projects
+ * without need of using the RawInput library. SDL can be found at https://www.libsdl.org
+ *
+ * Dependencies: SDL.dll
+ *               SDL_ttf.dll
+ *               SDL_img.dll
+ */
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include "Combo.h"
+
+//Bits used for the d-pad buttons that are held down
+#define DPAD_UP     1
+#define DPAD_DOWN   2
+#define DPAD_LEFT   4
+#define DPAD_RIGHT  8
+
+ComboEngine::ComboEngine()
+{
+    stickX = 0;
+    stickY = 0;
+    dpad = 0;
+    lastDirection = 5;
+    triggerLeft = false;
+    triggerRight = false;
+
+    reset();
+}
+
+bool ComboEngine::load(const char* file)
+{
+    std::ifstream in(file);
+
+    //A missing file is reported, but the program can still run without any combos
+    if(!in)
+    {
+        printf("Could not open combo file %s\n", file);
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+
+    while(std::getline(in, line))
+    {
+        lineNumber++;
+
+        std::istringstream tokens(line);
+        std::string name;
+        long window = -1;
+
+        //Blank lines and lines starting with # are skipped
+        if(!(tokens >> name) || name[0] == '#')
+        {
+            continue;
+        }
+
+        if(!(tokens >> window) || window < 0)
+        {
+            printf("%s line %d: expected a time window in ms after %s\n", file, lineNumber, name.c_str());
+            continue;
+        }
+
+        std::vector<int> sequence;
+        std::string token;
+        bool valid = true;
+
+        while(tokens >> token)
+        {
+            if(!parseToken(token, sequence))
+            {
+                printf("%s line %d: unknown input %s\n", file, lineNumber, token.c_str());
+                valid = false;
+                break;
+            }
+        }
+
+        if(valid && !addCombo(name, (Uint32)window, sequence))
+        {
+            printf("%s line %d: %s must have between 1 and %d inputs\n", file, lineNumber, name.c_str(), COMBO_MAX_LENGTH);
+        }
+    }
+
+    compile();
+    printf("%d combos loaded from %s, %d states\n", getComboCount(), file, getStateCount());
+
+    return true;
+}
+
+bool ComboEngine::addCombo(const std::string& name, Uint32 window, const std::vector<int>& sequence)
+{
+    if(sequence.empty() || sequence.size() > COMBO_MAX_LENGTH)
+    {
+        return false;
+    }
+
+    names.push_back(name);
+    windows.push_back(window);
+    sequences.push_back(sequence);
+
+    return true;
+}
+
+void ComboEngine::compile()
+{
+    const int S = COMBO_SYMBOL_TOTAL;
+
+    //Start with only the root state, which has no transitions yet
+    next.assign(S, -1);
+    output.assign(1, -1);
+    depth.assign(1, 0);
+
+    //Build a tree of every combo, sharing states between combos that start the same way
+    for(size_t i = 0; i < sequences.size(); i++)
+    {
+        int s = 0;
+
+        for(size_t j = 0; j < sequences[i].size(); j++)
+        {
+            int sym = sequences[i][j];
+
+            if(next[s * S + sym] == -1)
+            {
+                next[s * S + sym] = (int)output.size();
+                next.resize(next.size() + S, -1);
+                output.push_back(-1);
+                depth.push_back(depth[s] + 1);
+            }
+            s = next[s * S + sym];
+        }
+
+        if(output[s] == -1)
+        {
+            output[s] = (int)i;
+        }
+        else
+        {
+            printf("Combo %s has the same inputs as %s and will never be shown\n", names[i].c_str(), names[output[s]].c_str());
+        }
+    }
+
+    //Fill in the missing transitions in order of depth. A missing transition goes wherever the longest
+    //matching suffix of the inputs so far would go, so the machine never has to back up
+    std::vector<int> fail(output.size(), 0);
+    std::vector<int> queue;
+    queue.reserve(output.size());
+    dictLink.assign(output.size(), 0);
+
+    for(int c = 0; c < S; c++)
+    {
+        if(next[c] == -1)
+        {
+            next[c] = 0;
+        }
+        else
+        {
+            queue.push_back(next[c]);
+        }
+    }
+
+    for(size_t q = 0; q < queue.size(); q++)
+    {
+        int u = queue[q];
+        int f = fail[u];
+
+        dictLink[u] = (output[f] != -1) ? f : dictLink[f];
+
+        for(int c = 0; c < S; c++)
+        {
+            int v = next[u * S + c];
+
+            if(v == -1)
+            {
+                next[u * S + c] = next[f * S + c];
+            }
+            else
+            {
+                fail[v] = next[f * S + c];
+                queue.push_back(v);
+            }
+        }
+    }
+
+    reset();
+}
+
+int ComboEngine::processEvent(const SDL_Event& e)
+{
+    if(e.type == SDL_CONTROLLERAXISMOTION && e.caxis.which == 0)
+    {
+        bool pressed = e.caxis.value > COMBO_THRESHOLD;
+
+        switch(e.caxis.axis)
+        {
+        case SDL_CONTROLLER_AXIS_LEFTX:
+            stickX = e.caxis.value;
+            return sendDirection(e.caxis.timestamp);
+
+        case SDL_CONTROLLER_AXIS_LEFTY:
+            stickY = e.caxis.value;
+            return sendDirection(e.caxis.timestamp);
+
+        //Triggers only count once each time they are pulled past the threshold
+        case SDL_CONTROLLER_AXIS_TRIGGERLEFT:
+            if(pressed && !triggerLeft)
+            {
+                triggerLeft = true;
+                return feed(COMBO_SYMBOL_TRIGGERLEFT, e.caxis.timestamp);
+            }
+            triggerLeft = pressed;
+            break;
+
+        case SDL_CONTROLLER_AXIS_TRIGGERRIGHT:
+            if(pressed && !triggerRight)
+            {
+                triggerRight = true;
+                return feed(COMBO_SYMBOL_TRIGGERRIGHT, e.caxis.timestamp);
+            }
+            triggerRight = pressed;
+            break;
+
+        default:
+            break;
+        }
+    }
+    //The d-pad is treated as a direction, the same as the left stick
+    else if((e.type == SDL_CONTROLLERBUTTONDOWN || e.type == SDL_CONTROLLERBUTTONUP) && e.cbutton.which == 0)
+    {
+        int bit = 0;
+
+        switch(e.cbutton.button)
+        {
+        case SDL_CONTROLLER_BUTTON_DPAD_UP:
+            bit = DPAD_UP;
+            break;
+        case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
+            bit = DPAD_DOWN;
+            break;
+        case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
+            bit = DPAD_LEFT;
+            break;
+        case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
+            bit = DPAD_RIGHT;
+            break;
+        default:
+            break;
+        }
+
+        if(bit != 0)
+        {
+            if(e.type == SDL_CONTROLLERBUTTONDOWN)
+            {
+                dpad |= bit;
+            }
+            else
+            {
+                dpad &= ~bit;
+            }
+            return sendDirection(e.cbutton.timestamp);
+        }
+        else if(e.type == SDL_CONTROLLERBUTTONDOWN && e.cbutton.button < SDL_CONTROLLER_BUTTON_MAX)
+        {
+            return feed(COMBO_SYMBOL_BUTTON(e.cbutton.button), e.cbutton.timestamp);
+        }
+    }
+
+    return -1;
+}
+
+int ComboEngine::feed(int symbol, Uint32 time)
+{
+    if(next.empty() || symbol < 0 || symbol >= COMBO_SYMBOL_TOTAL)
+    {
+        return -1;
+    }
+
+    state = next[state * COMBO_SYMBOL_TOTAL + symbol];
+
+    times[timeHead] = time;
+    timeHead = (timeHead + 1) % COMBO_MAX_LENGTH;
+
+    //Check the longest combo ending here first, then each shorter one, until one was entered fast enough
+    int n = (output[state] != -1) ? state : dictLink[state];
+
+    while(n != 0)
+    {
+        int combo = output[n];
+        Uint32 first = times[(timeHead - depth[n] + COMBO_MAX_LENGTH) % COMBO_MAX_LENGTH];
+
+        if(time - first <= windows[combo])
+        {
+            return combo;
+        }
+        n = dictLink[n];
+    }
+
+    return -1;
+}
+
+void ComboEngine::reset()
+{
+    state = 0;
+    timeHead = 0;
+
+    for(int i = 0; i < COMBO_MAX_LENGTH; i++)
+    {
+        times[i] = 0;
+    }
+}
+
+const char* ComboEngine::getName(int combo)
+{
+    if(combo < 0 || combo >= (int)names.size())
+    {
+        return "";
+    }
+
+    return names[combo].c_str();
+}
+
+int ComboEngine::getComboCount()
+{
+    return (int)names.size();
+}
+
+int ComboEngine::getStateCount()
+{
+    return (int)output.size();
+}
+
+bool ComboEngine::parseToken(const std::string& token, std::vector<int>& sequence)
+{
+    //Numbers are directions in numpad notation, so 236 is down, down-forward, forward
+    if(token.find_first_not_of("12346789") == std::string::npos)
+    {
+        for(size_t i = 0; i < token.size(); i++)
+        {
+            sequence.push_back(COMBO_SYMBOL_DIRECTION(token[i] - '0'));
+        }
+        return true;
+    }
+
+    //Triggers use the same names as in gamecontrollerdb.txt
+    if(token == "lefttrigger")
+    {
+        sequence.push_back(COMBO_SYMBOL_TRIGGERLEFT);
+        return true;
+    }
+    if(token == "righttrigger")
+    {
+        sequence.push_back(COMBO_SYMBOL_TRIGGERRIGHT);
+        return true;
+    }
+
+    //Anything else must be a button name, such as a, x or leftshoulder. The d-pad must be written as directions
+    SDL_GameControllerButton button = SDL_GameControllerGetButtonFromString(token.c_str());
+
+    if(button == SDL_CONTROLLER_BUTTON_INVALID || (button >= SDL_CONTROLLER_BUTTON_DPAD_UP && button <= SDL_CONTROLLER_BUTTON_DPAD_RIGHT))
+    {
+        return false;
+    }
+
+    sequence.push_back(COMBO_SYMBOL_BUTTON(button));
+    return true;
+}
+
+//Numpad direction of the d-pad, or the left stick if no d-pad buttons are held. Up on the stick is negative
+int ComboEngine::getDirection()
+{
+    int h = 0;
+    int v = 0;
+
+    if(dpad != 0)
+    {
+        h = ((dpad & DPAD_RIGHT) ? 1 : 0) - ((dpad & DPAD_LEFT) ? 1 : 0);
+        v = ((dpad & DPAD_UP) ? 1 : 0) - ((dpad & DPAD_DOWN) ? 1 : 0);
+    }
+    else
+    {
+        h = (stickX > COMBO_THRESHOLD) ? 1 : ((stickX < -COMBO_THRESHOLD) ? -1 : 0);
+        v = (stickY < -COMBO_THRESHOLD) ? 1 : ((stickY > COMBO_THRESHOLD) ? -1 : 0);
+    }
+
+    return 5 + h + 3 * v;
+}
+
+//Sends a direction only when it changes. Returning to neutral is not sent, so 2 5 3 6 still reads as 236
+int ComboEngine::sendDirection(Uint32 time)
+{
+    int direction = getDirection();
+
+    if(direction == lastDirection)
+    {
+        return -1;
+    }
+
+    lastDirection = direction;
+
+    if(direction == 5)
+    {
+        return -1;
+    }
+
+    return feed(COMBO_SYMBOL_DIRECTION(direction), time);
+}
+
+void benchmarkCombos()
+{
+    const int sizes[] = {10, 100, 1000, 5000, 10000};
+    const int sizeTotal = sizeof(sizes) / sizeof(sizes[0]);
+    const int maxCombos = sizes[sizeTotal - 1];
+    const int streamLength = 2000000;
+
+    //Fixed seed so every run replays the same combos and inputs
+    srand(1);
+
+    //Combos look like motion inputs: 1 to 4 directions followed by 1 or 2 buttons. Duplicates are thrown away
+    std::vector< std::vector<int> > combos;
+    std::vector<Uint32> comboWindows;
+    std::set< std::vector<int> > seen;
+
+    while((int)combos.size() < maxCombos)
+    {
+        std::vector<int> combo;
+        int directions = 1 + rand() % 4;
+        int buttons = 1 + rand() % 2;
+
+        for(int j = 0; j < directions; j++)
+        {
+            int d = 1 + rand() % 8;
+            combo.push_back(COMBO_SYMBOL_DIRECTION(d >= 5 ? d + 1 : d));
+        }
+        for(int j = 0; j < buttons; j++)
+        {
+            combo.push_back(COMBO_SYMBOL_BUTTON(rand() % SDL_CONTROLLER_BUTTON_DPAD_UP));
+        }
+
+        if(seen.insert(combo).second)
+        {
+            combos.push_back(combo);
+            comboWindows.push_back(200 + rand() % 600);
+        }
+    }
+
+    //The replayed stream mixes random noise with combos taken from the smallest set, so every set gets matches
+    std::vector<int> stream;
+    std::vector<Uint32> streamTimes;
+    Uint32 time = 0;
+
+    stream.reserve(streamLength);
+    streamTimes.reserve(streamLength);
+
+    while((int)stream.size() < streamLength)
+    {
+        if(rand() % 4 == 0)
+        {
+            const std::vector<int>& combo = combos[rand() % sizes[0]];
+
+            for(size_t j = 0; j < combo.size() && (int)stream.size() < streamLength; j++)
+            {
+                time += 16 + rand() % 50;
+                stream.push_back(combo[j]);
+                streamTimes.push_back(time);
+            }
+        }
+        else
+        {
+            time += 16 + rand() % 100;
+            stream.push_back(rand() % COMBO_SYMBOL_TOTAL);
+            streamTimes.push_back(time);
+        }
+    }
+
+    printf("Replaying %d inputs\n", streamLength);
+    printf("%8s %8s %10s %14s\n", "Combos", "States", "Matches", "ns per input");
+
+    for(int s = 0; s < sizeTotal; s++)
+    {
+        ComboEngine engine;
+        char name[32];
+
+        for(int i = 0; i < sizes[s]; i++)
+        {
+            sprintf(name, "combo%d", i);
+            engine.addCombo(name, comboWindows[i], combos[i]);
+        }
+        engine.compile();
+
+        int matches = 0;
+        Uint64 begin = SDL_GetPerformanceCounter();
+
+        for(int i = 0; i < streamLength; i++)
+        {
+            if(engine.feed(stream[i], streamTimes[i]) >= 0)
+            {
+                matches++;
+            }
+        }
+
+        Uint64 end = SDL_GetPerformanceCounter();
+        double ns = (double)(end - begin) * 1000000000.0 / SDL_GetPerformanceFrequency() / streamLength;
+
+        printf("%8d %8d %10d %14.2f\n", sizes[s], engine.getStateCount(), matches, ns);
+    }
+}
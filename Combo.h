@@ -0,0 +1,97 @@
+/* Input sequence detection. Combos such as quarter circle + button are loaded from a text file
+ * and compiled into a single state machine, so that checking each input costs the same no matter
+ * how many combos are loaded
+ *
+ * Project Name: SDL_Game_Input
+ * Author:       Jake Moses
+ *
+ * Purpose: This project is meant to test gamepad input using the SDL
+ * suite. Parts of this may be used to ignore XInput for DirectX projects
+ * without need of using the RawInput library. SDL can be found at https://www.libsdl.org
+ *
+ * Dependencies: SDL.dll
+ *               SDL_ttf.dll
+ *               SDL_img.dll
+ */
+
+#ifndef COMBO_H_INCLUDED
+#define COMBO_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+//Longest combo that can be defined, in inputs. This also bounds the work done per input
+#define COMBO_MAX_LENGTH    16
+//Axis value past which a stick counts as pushed, or a trigger as pressed
+#define COMBO_THRESHOLD     16000
+
+//Input symbols. Directions use numpad notation (1 = down-left, 6 = forward, 9 = up-right). 5 is neutral and is never sent
+#define COMBO_SYMBOL_DIRECTION(d)   ((d) - 1)
+#define COMBO_SYMBOL_BUTTON(b)      (9 + (b))
+#define COMBO_SYMBOL_TRIGGERLEFT    (9 + SDL_CONTROLLER_BUTTON_MAX)
+#define COMBO_SYMBOL_TRIGGERRIGHT   (10 + SDL_CONTROLLER_BUTTON_MAX)
+#define COMBO_SYMBOL_TOTAL          (11 + SDL_CONTROLLER_BUTTON_MAX)
+
+//Class that loads combo definitions and matches them against controller events
+class ComboEngine
+{
+public:
+    ComboEngine();
+
+    //Loads combos from a file, one per line: name, time window in ms, then the inputs. Compiles the state machine when done
+    bool load(const char*);
+    //Adds one combo. The state machine must be rebuilt with compile() before it is used
+    bool addCombo(const std::string&, Uint32, const std::vector<int>&);
+    //Builds the state machine from every combo added so far
+    void compile();
+
+    //Turns a controller event into input symbols and runs them through the state machine. Returns the matched combo or -1
+    int processEvent(const SDL_Event&);
+    //Runs one input symbol through the state machine. Returns the longest combo completed within its window, or -1
+    int feed(int, Uint32);
+    //Returns to the starting state and forgets all previous inputs
+    void reset();
+
+    const char* getName(int);
+    int getComboCount();
+    int getStateCount();
+
+private:
+    //Reads a single input token from a combo file. Digits are split into several directions
+    bool parseToken(const std::string&, std::vector<int>&);
+    int getDirection();
+    int sendDirection(Uint32);
+
+    //The combos as loaded
+    std::vector<std::string> names;
+    std::vector<Uint32> windows;
+    std::vector< std::vector<int> > sequences;
+
+    //The compiled state machine. next holds COMBO_SYMBOL_TOTAL entries per state
+    std::vector<int> next;
+    //Combo that ends at each state, or -1
+    std::vector<int> output;
+    //Next shorter state that also ends a combo, or 0 if there is none
+    std::vector<int> dictLink;
+    //Number of inputs that lead to each state
+    std::vector<int> depth;
+
+    int state;
+
+    //Times of the most recent inputs, used to check combo windows
+    Uint32 times[COMBO_MAX_LENGTH];
+    int timeHead;
+
+    //Current stick, d-pad and trigger state, used to turn axis events into symbols
+    Sint16 stickX;
+    Sint16 stickY;
+    int dpad;
+    int lastDirection;
+    bool triggerLeft;
+    bool triggerRight;
+};
+
+//Times the combo engine against a replayed input stream with increasing numbers of combos loaded
+void benchmarkCombos();
+
+#endif // COMBO_H_INCLUDED
@@ -0,0 +1,368 @@
+/* Definitions for functions declared in Soak.h
+ *
+ * Project Name: SDL_Game_Input
+ * Author:       Jake Moses
+ *
+ * Purpose: This project is meant to test gamepad input using the SDL
+ * suite. Parts of this may be used to ignore XInput for DirectX projects
+ * without need of using the RawInput library. SDL can be found at https://www.libsdl.org
+ *
+ * Dependencies: SDL.dll
+ *               SDL_ttf.dll
+ *               SDL_img.dll
+ */
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <stdio.h>
+#ifdef _WIN32
+//Version 2 maps the memory functions to kernel32, so psapi does not need to be linked
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+#include "global.h"
+#include "Soak.h"
+
+//Names of each tracked value, in the order of the SOAK_METRIC defines
+static const char* metricNames[SOAK_METRICS] = {"RSS (KB)", "Textures", "Events per frame", "Frame time (ms)"};
+
+//How far a value may drop between history entries and still count as not decreasing. Frame time is noisy,
+//so it is allowed to drop by a fraction of its value
+static double growthNoise(int m, double value)
+{
+    switch(m)
+    {
+    case SOAK_METRIC_RSS:
+        return 256.0;
+    case SOAK_METRIC_FRAMETIME:
+        return value * 0.05;
+    default:
+        return 0.0;
+    }
+}
+
+//How much a value must rise overall before it is flagged
+static double growthMargin(int m, double value)
+{
+    switch(m)
+    {
+    case SOAK_METRIC_RSS:
+        return 1024.0;
+    case SOAK_METRIC_FRAMETIME:
+        return value * 0.10 + 0.05;
+    default:
+        return 0.0;
+    }
+}
+
+//Buttons cycled through by the synthetic input
+static const Uint8 soakButtons[] = {SDL_CONTROLLER_BUTTON_X,
+                                    SDL_CONTROLLER_BUTTON_A,
+                                    SDL_CONTROLLER_BUTTON_B,
+                                    SDL_CONTROLLER_BUTTON_Y,
+                                    SDL_CONTROLLER_BUTTON_LEFTSHOULDER,
+                                    SDL_CONTROLLER_BUTTON_RIGHTSHOULDER,
+                                    SDL_CONTROLLER_BUTTON_BACK,
+                                    SDL_CONTROLLER_BUTTON_START,
+                                    SDL_CONTROLLER_BUTTON_LEFTSTICK,
+                                    SDL_CONTROLLER_BUTTON_RIGHTSTICK,
+                                    SDL_CONTROLLER_BUTTON_GUIDE};
+static const int soakButtonTotal = sizeof(soakButtons) / sizeof(soakButtons[0]);
+
+Soak::Soak()
+{
+    head = 0;
+    count = 0;
+    start = 0;
+    lastSample = 0;
+    duration = 0;
+    tick = 0;
+    enabled = false;
+    frameTotal = 0.0;
+    frames = 0;
+    maxQueued = 0;
+    blockSamples = 0;
+    historyHead = 0;
+    historyCount = 0;
+
+    for(int i = 0; i < SOAK_METRICS; i++)
+    {
+        blockMin[i] = 0.0;
+        flagged[i] = false;
+    }
+}
+
+Soak::~Soak()
+{
+    if(enabled)
+    {
+        report();
+    }
+}
+
+void Soak::begin(Uint32 seconds)
+{
+    enabled = true;
+    start = SDL_GetTicks();
+    lastSample = start;
+    duration = seconds * 1000;
+
+    printf("Soak mode started. Sampling every %d ms", SOAK_INTERVAL);
+    if(duration > 0)
+    {
+        printf(" for %u seconds", seconds);
+    }
+    printf(".\n");
+}
+
+bool Soak::isEnabled()
+{
+    return enabled;
+}
+
+void Soak::injectInput()
+{
+    if(!enabled)
+    {
+        return;
+    }
+
+    SDL_Event e;
+
+    //Every frame moves one axis. The value sweeps back and forth across the whole range so the text keeps changing
+    SDL_zero(e);
+    e.type = SDL_CONTROLLERAXISMOTION;
+    e.caxis.which = 0;
+    e.caxis.axis = tick % SDL_CONTROLLER_AXIS_MAX;
+    e.caxis.value = (Sint16)((int)((tick * 997) % 65536) - 32768);
+    SDL_PushEvent(&e);
+
+    //Every 8 frames a button is pressed, and released 4 frames later
+    if(tick % 8 == 0 || tick % 8 == 4)
+    {
+        SDL_zero(e);
+        e.type = (tick % 8 == 0) ? SDL_CONTROLLERBUTTONDOWN : SDL_CONTROLLERBUTTONUP;
+        e.cbutton.which = 0;
+        e.cbutton.button = soakButtons[(tick / 8) % soakButtonTotal];
+        e.cbutton.state = (tick % 8 == 0) ? SDL_PRESSED : SDL_RELEASED;
+        SDL_PushEvent(&e);
+    }
+
+    tick++;
+}
+
+void Soak::update(double frameTime, int events)
+{
+    if(!enabled)
+    {
+        return;
+    }
+
+    frameTotal += frameTime;
+    frames++;
+
+    //SDL_PollEvent pumps the OS and controller events in, so this is how many were waiting when the frame began
+    if(events > maxQueued)
+    {
+        maxQueued = events;
+    }
+
+    if(SDL_GetTicks() - lastSample >= SOAK_INTERVAL)
+    {
+        sample();
+    }
+}
+
+bool Soak::finished()
+{
+    return enabled && duration > 0 && SDL_GetTicks() - start >= duration;
+}
+
+//Records the current state into the log, overwriting the oldest entry once the log is full
+void Soak::sample()
+{
+    SoakSample& s = samples[head];
+    Uint32 now = SDL_GetTicks();
+
+    s.time = now - start;
+    s.rss = getRSS();
+    s.textures = getTextureCount();
+    s.queued = maxQueued;
+    s.frameTime = (frames > 0) ? frameTotal / frames : 0.0;
+
+    printf("[soak] %10u ms  RSS %8ld KB  textures %4d  queued %4d  frame %7.3f ms\n",
+           s.time, s.rss, s.textures, s.queued, s.frameTime);
+
+    head = (head + 1) % SOAK_LOG_SIZE;
+    if(count < SOAK_LOG_SIZE)
+    {
+        count++;
+    }
+
+    lastSample = now;
+    frameTotal = 0.0;
+    frames = 0;
+    maxQueued = 0;
+
+    //Keep the lowest value of each metric in this block. Once the block is full it is added to the history
+    for(int m = 0; m < SOAK_METRICS; m++)
+    {
+        double value = getMetric(s, m);
+        if(blockSamples == 0 || value < blockMin[m])
+        {
+            blockMin[m] = value;
+        }
+    }
+    blockSamples++;
+
+    if(blockSamples == SOAK_BLOCK_SAMPLES)
+    {
+        for(int m = 0; m < SOAK_METRICS; m++)
+        {
+            history[historyHead][m] = blockMin[m];
+        }
+        historyHead = (historyHead + 1) % SOAK_HISTORY_SIZE;
+        if(historyCount < SOAK_HISTORY_SIZE)
+        {
+            historyCount++;
+        }
+        blockSamples = 0;
+
+        checkGrowth();
+    }
+}
+
+//Flags any value that has not dropped over the last hour, or over the whole history, and ended higher than it began.
+//Slow leaks rise in steps with flat stretches between them, so flat entries still count as growth
+void Soak::checkGrowth()
+{
+    for(int m = 0; m < SOAK_METRICS; m++)
+    {
+        int entries = SOAK_GROWTH_WINDOW;
+        bool growing = isGrowing(m, entries);
+
+        if(!growing && historyCount > SOAK_GROWTH_WINDOW)
+        {
+            entries = historyCount;
+            growing = isGrowing(m, entries);
+        }
+
+        if(growing && !flagged[m])
+        {
+            printf("[soak] WARNING: %s has not dropped in %d minutes and rose from %.3f to %.3f\n", metricNames[m],
+                   entries * SOAK_BLOCK_SAMPLES * SOAK_INTERVAL / 60000, getHistory(m, entries - 1), getHistory(m, 0));
+        }
+        flagged[m] = growing;
+    }
+}
+
+//Returns true if metric m never dropped by more than the noise across the newest entries in the history,
+//and the newest entry is above the oldest by more than the margin
+bool Soak::isGrowing(int m, int entries)
+{
+    if(entries < 2 || entries > historyCount)
+    {
+        return false;
+    }
+
+    double first = getHistory(m, entries - 1);
+    double last = getHistory(m, 0);
+
+    //RSS is -1 on platforms that do not report it
+    if(first < 0 || last < 0)
+    {
+        return false;
+    }
+
+    //age counts back from the newest entry, which is at age 0
+    for(int age = entries - 1; age > 0; age--)
+    {
+        double previous = getHistory(m, age);
+        if(getHistory(m, age - 1) < previous - growthNoise(m, previous))
+        {
+            return false;
+        }
+    }
+
+    return last - first > growthMargin(m, first);
+}
+
+//Returns metric m from the history entry added age entries ago
+double Soak::getHistory(int m, int age)
+{
+    return history[(historyHead - 1 - age + SOAK_HISTORY_SIZE) % SOAK_HISTORY_SIZE][m];
+}
+
+//Returns metric m from a sample
+double Soak::getMetric(const SoakSample& s, int m)
+{
+    switch(m)
+    {
+    case SOAK_METRIC_RSS:
+        return (double)s.rss;
+    case SOAK_METRIC_TEXTURES:
+        return (double)s.textures;
+    case SOAK_METRIC_QUEUED:
+        return (double)s.queued;
+    default:
+        return s.frameTime;
+    }
+}
+
+//Resident memory of this process in KB. Returns -1 if the platform does not report it
+long Soak::getRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    {
+        return (long)(pmc.WorkingSetSize / 1024);
+    }
+    return -1;
+#else
+    long pages = -1;
+    FILE* statm = fopen("/proc/self/statm", "r");
+
+    if(statm == NULL)
+    {
+        return -1;
+    }
+    if(fscanf(statm, "%*s %ld", &pages) != 1)
+    {
+        pages = -1;
+    }
+    fclose(statm);
+
+    return (pages < 0) ? -1 : pages * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+void Soak::report()
+{
+    printf("Soak log, %d samples:\n", count);
+
+    for(int i = count - 1; i >= 0; i--)
+    {
+        const SoakSample& s = samples[(head - 1 - i + SOAK_LOG_SIZE) % SOAK_LOG_SIZE];
+        printf("%10u ms  RSS %8ld KB  textures %4d  queued %4d  frame %7.3f ms\n",
+               s.time, s.rss, s.textures, s.queued, s.frameTime);
+    }
+
+    //Growth is only checked once there is a full window of history, so short runs say so instead of looking clean
+    if(historyCount < SOAK_GROWTH_WINDOW)
+    {
+        printf("Growth not evaluated (needs %d min of soak time)\n", SOAK_GROWTH_WINDOW * SOAK_BLOCK_SAMPLES * SOAK_INTERVAL / 60000);
+    }
+
+    for(int m = 0; m < SOAK_METRICS; m++)
+    {
+        if(flagged[m])
+        {
+            printf("WARNING: %s was still growing when soak mode ended\n", metricNames[m]);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/* Soak mode for leaving the program running unattended for long periods. Synthetic controller
+ * input is pushed every frame, and resource usage is sampled into a fixed size log so that
+ * leaks and slow growth can be spotted without a controller being plugged in
+ *
+ * Project Name: SDL_Game_Input
+ * Author:       Jake Moses
+ *
+ * Purpose: This project is meant to test gamepad input using the SDL
+ * suite. Parts of this may be used to ignore XInput for DirectX projects
+ * without need of using the RawInput library. SDL can be found at https://www.libsdl.org
+ *
+ * Dependencies: SDL.dll
+ *               SDL_ttf.dll
+ *               SDL_img.dll
+ */
+
+#ifndef SOAK_H_INCLUDED
+#define SOAK_H_INCLUDED
+
+//Number of samples kept in the log. Once full, the oldest sample is overwritten
+#define SOAK_LOG_SIZE       512
+//Milliseconds between samples
+#define SOAK_INTERVAL       5000
+//Number of samples combined into each history entry, which keeps the lowest value seen (5 minutes at the default interval)
+#define SOAK_BLOCK_SAMPLES  60
+//Number of entries kept in the long term history (24 hours at the default interval)
+#define SOAK_HISTORY_SIZE   288
+//Number of history entries checked for recent growth (1 hour at the default interval)
+#define SOAK_GROWTH_WINDOW  12
+//Values tracked in each sample, used to index the history and the names printed in warnings
+#define SOAK_METRIC_RSS         0
+#define SOAK_METRIC_TEXTURES    1
+#define SOAK_METRIC_QUEUED      2
+#define SOAK_METRIC_FRAMETIME   3
+#define SOAK_METRICS            4
+
+//One entry in the soak log
+struct SoakSample
+{
+    Uint32 time;        //Milliseconds since soak mode started
+    long rss;           //Resident memory in KB, -1 if unavailable
+    int textures;       //Textures currently alive
+    int queued;         //Most events handled in one frame since the previous sample, including the synthetic ones
+    double frameTime;   //Average frame time in ms since the previous sample
+};
+
+//Class that drives input and records resource usage while soak mode is running
+class Soak
+{
+public:
+    //Soak mode starts disabled, and nothing below has any effect until begin is called
+    Soak();
+    //Prints the log if soak mode was started
+    ~Soak();
+
+    //Starts soak mode. Duration is in seconds. A duration of 0 runs until the window is closed
+    void begin(Uint32);
+    bool isEnabled();
+
+    //Pushes the next set of synthetic controller events onto the SDL event queue
+    void injectInput();
+    //Adds the time of the last frame in ms and the number of events handled in it, and takes a sample once the interval has passed
+    void update(double, int);
+    //Returns true once the requested duration has passed
+    bool finished();
+    //Prints every sample still held in the log
+    void report();
+
+private:
+    void sample();
+    void checkGrowth();
+    bool isGrowing(int, int);
+    double getMetric(const SoakSample&, int);
+    double getHistory(int, int);
+    long getRSS();
+
+    SoakSample samples[SOAK_LOG_SIZE];
+    int head;
+    int count;
+
+    Uint32 start;
+    Uint32 lastSample;
+    Uint32 duration;
+    Uint32 tick;
+    bool enabled;
+
+    double frameTotal;
+    int frames;
+    int maxQueued;
+
+    //Lowest value of each metric in the block being collected, and how many samples it holds so far
+    double blockMin[SOAK_METRICS];
+    int blockSamples;
+
+    //Long term history of block minimums. Using the lowest value hides short spikes, so only lasting growth shows
+    double history[SOAK_HISTORY_SIZE][SOAK_METRICS];
+    int historyHead;
+    int historyCount;
+
+    bool flagged[SOAK_METRICS];
+};
+
+#endif // SOAK_H_INCLUDED
@@ -16,6 +16,7 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
+#include "global.h"
 #include "Text.h"
 
 Overlay::Overlay()
@@ -23,6 +24,11 @@ Overlay::Overlay()
     oTexture = NULL;
     width = 0;
     height = 0;
+    oFont = NULL;
+    oColor.r = 0;
+    oColor.g = 0;
+    oColor.b = 0;
+    oColor.a = 0;
 }
 
 Overlay::~Overlay()
@@ -32,6 +38,13 @@ Overlay::~Overlay()
 
 void Overlay::createFromText(const char* text, SDL_Color fColor, TTF_Font* font, SDL_Renderer* renderer)
 {
+    //Axis events arrive far more often than the value changes, so identical text keeps the existing texture
+    if(oTexture != NULL && oFont == font && oText == text &&
+       oColor.r == fColor.r && oColor.g == fColor.g && oColor.b == fColor.b && oColor.a == fColor.a)
+    {
+        return;
+    }
+
     //Before creating the new texture, destroy the old one
     free();
 
@@ -45,7 +58,7 @@ void Overlay::createFromText(const char* text, SDL_Color fColor, TTF_Font* font,
     //If prior process is successful, a texture is created from the created surface
     else
     {
-        oTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        oTexture = createTexture(renderer, textSurface);
 
         if (oTexture == NULL)
         {
@@ -56,6 +69,9 @@ void Overlay::createFromText(const char* text, SDL_Color fColor, TTF_Font* font,
         {
             width = textSurface->w;
             height = textSurface->h;
+            oText = text;
+            oColor = fColor;
+            oFont = font;
         }
     }
     //Destroys previously created surface
@@ -67,10 +83,11 @@ void Overlay::free()
 {
     if(oTexture != NULL)
     {
-        SDL_DestroyTexture(oTexture);
-        oTexture = NULL;
+        destroyTexture(oTexture);
         width = 0;
         height = 0;
+        oText.clear();
+        oFont = NULL;
     }
 }
 
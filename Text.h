@@ -17,6 +17,8 @@
 #ifndef TEXT_H_INCLUDED
 #define TEXT_H_INCLUDED
 
+#include <string>
+
 //Class for overlay text to be painted on screen
 class Overlay
 {
@@ -24,7 +26,7 @@ public:
     Overlay();
     ~Overlay();
 
-    //Creates a new surface from text given
+    //Creates a new surface from text given. Nothing is recreated if the text, color and font are unchanged
     void createFromText(const char*, SDL_Color, TTF_Font*, SDL_Renderer*);
     //Destroys previous surface to prevent repeat initialization issues
     void free();
@@ -47,6 +49,15 @@ private:
     int width;
     int height;
 
+    //What the current texture was created from, used to skip recreating identical text
+    std::string oText;
+    SDL_Color oColor;
+    TTF_Font* oFont;
+
+    //Each Overlay owns its texture, so copying is not allowed
+    Overlay(const Overlay&);
+    Overlay& operator=(const Overlay&);
+
 };
 
 #endif // TEXT_H_INCLUDED
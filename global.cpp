@@ -19,10 +19,15 @@
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <iostream>
+#include <fstream>
+#include <string>
 #include "global.h"
 
+//Number of textures currently alive. Used by soak mode to detect leaks
+static int textureCount = 0;
+
 //Initialize SDL, along with the window that SDL will be using
-bool init_window(SDL_Window*& window, SDL_Renderer*& renderer, const char* title, int x, int y, int w, int h, Uint32 flags)
+bool init_window(SDL_Window*& window, SDL_Renderer*& renderer, const char* title, int x, int y, int w, int h, Uint32 flags, const RendererOptions& options)
 {
     bool success = true;
 
@@ -58,7 +63,7 @@ bool init_window(SDL_Window*& window, SDL_Renderer*& renderer, const char* title
         else
         {
             //Attempts to create the renderer. If this fails, a reason will be given, and the program will not continue
-            if(!init_Renderer(renderer, window))
+            if(!init_Renderer(renderer, window, options))
             {
                 printf("Renderer could not be initialized. See above this line for details.\n");
                 success = false;
@@ -69,13 +74,244 @@ bool init_window(SDL_Window*& window, SDL_Renderer*& renderer, const char* title
     return success;
 }
 
+//Draws a short workload similar to one frame of the program: a full screen background and a few text
+//sized overlays. Returns the average ms per frame, or -1 if the workload could not be set up
+static double timeRenderer(SDL_Renderer* renderer, SDL_Window* window)
+{
+    int w = 0;
+    int h = 0;
+    double cost = -1.0;
+
+    SDL_GetWindowSize(window, &w, &h);
+
+    SDL_Surface* bSurface = SDL_CreateRGBSurface(0, w, h, 32, 0, 0, 0, 0);
+    SDL_Surface* oSurface = SDL_CreateRGBSurface(0, 120, 40, 32, 0, 0, 0, 0);
+    SDL_Texture* background = NULL;
+    SDL_Texture* overlay = NULL;
+
+    if(bSurface != NULL && oSurface != NULL)
+    {
+        SDL_FillRect(bSurface, NULL, 0x00808080);
+        SDL_FillRect(oSurface, NULL, 0x00FF0000);
+        background = createTexture(renderer, bSurface);
+        overlay = createTexture(renderer, oSurface);
+    }
+
+    if(background != NULL && overlay != NULL)
+    {
+        Uint64 start = 0;
+        Uint32 pixel = 0;
+        SDL_Rect one = {0, 0, 1, 1};
+
+        for(int f = 0; f < RENDER_BENCH_WARMUP + RENDER_BENCH_FRAMES; f++)
+        {
+            if(f == RENDER_BENCH_WARMUP)
+            {
+                start = SDL_GetPerformanceCounter();
+            }
+
+            SDL_RenderClear(renderer);
+            SDL_RenderCopy(renderer, background, NULL, NULL);
+            for(int i = 0; i < RENDER_BENCH_OVERLAYS; i++)
+            {
+                SDL_Rect quad = {50 + (i % 2) * (w - 220), 100 + (i / 2) * 75, 120, 40};
+                SDL_RenderCopy(renderer, overlay, NULL, &quad);
+            }
+            SDL_RenderPresent(renderer);
+        }
+
+        //Reading a pixel back waits for any queued drawing to finish, so it is included in the time
+        SDL_RenderReadPixels(renderer, &one, 0, &pixel, sizeof(pixel));
+
+        cost = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / RENDER_BENCH_FRAMES;
+    }
+
+    destroyTexture(background);
+    destroyTexture(overlay);
+    if(bSurface != NULL)
+    {
+        SDL_FreeSurface(bSurface);
+    }
+    if(oSurface != NULL)
+    {
+        SDL_FreeSurface(oSurface);
+    }
+
+    return cost;
+}
+
+//Creates a renderer with the given driver without vsync, times it, and destroys it again
+static double timeDriver(int index, SDL_Window* window)
+{
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, index, 0);
+
+    if(renderer == NULL)
+    {
+        return -1.0;
+    }
+
+    double cost = timeRenderer(renderer, window);
+    SDL_DestroyRenderer(renderer);
+
+    return cost;
+}
+
+//Path of the file that remembers the chosen driver. Empty if SDL has no preference folder for this platform
+static std::string rendererCachePath()
+{
+    std::string path;
+    char* pref = SDL_GetPrefPath("Jake Moses", "SDL_Game_Input");
+
+    if(pref != NULL)
+    {
+        path = std::string(pref) + RENDER_CACHE_FILE;
+        SDL_free(pref);
+    }
+
+    return path;
+}
+
+//Comma separated names of every render driver. This is saved with the choice, so a change of drivers causes them to be timed again
+static std::string availableDrivers()
+{
+    std::string available;
+    SDL_RendererInfo info;
+
+    for(int i = 0; i < SDL_GetNumRenderDrivers(); i++)
+    {
+        if(SDL_GetRenderDriverInfo(i, &info) == 0)
+        {
+            available += std::string(info.name) + ",";
+        }
+    }
+
+    return available;
+}
+
+//Saves the driver to use on later runs along with its frame cost, which is -1 if it was not measured
+static void saveDriver(const char* name, double cost)
+{
+    std::string path = rendererCachePath();
+
+    if(!path.empty())
+    {
+        std::ofstream out(path.c_str());
+        out << name << "\n" << cost << "\n" << availableDrivers() << "\n";
+    }
+}
+
+//Chooses the render driver to use. An override is used if it exists, then a saved choice if the same drivers are
+//still available, otherwise every driver is timed and the fastest is saved. Returns the driver index, or -1 if none worked
+static int chooseDriver(SDL_Window* window, const RendererOptions& options, double& cost, const char*& source)
+{
+    int total = SDL_GetNumRenderDrivers();
+    std::string available = availableDrivers();
+    SDL_RendererInfo info;
+
+    if(options.driver != NULL)
+    {
+        for(int i = 0; i < total; i++)
+        {
+            if(SDL_GetRenderDriverInfo(i, &info) == 0 && std::string(info.name) == options.driver)
+            {
+                source = "override";
+                cost = timeDriver(i, window);
+                return i;
+            }
+        }
+        printf("Render driver %s is not available. Available drivers: %s\n", options.driver, available.c_str());
+    }
+
+    std::string path = rendererCachePath();
+
+    if(!options.benchmark && !path.empty())
+    {
+        std::ifstream in(path.c_str());
+        std::string name;
+        std::string saved;
+
+        if(in >> name >> cost >> saved && saved == available)
+        {
+            for(int i = 0; i < total; i++)
+            {
+                if(SDL_GetRenderDriverInfo(i, &info) == 0 && name == info.name)
+                {
+                    source = "saved";
+                    return i;
+                }
+            }
+        }
+    }
+
+    int best = -1;
+    cost = -1.0;
+    source = "measured";
+
+    printf("Timing %d render drivers:\n", total);
+    for(int i = 0; i < total; i++)
+    {
+        if(SDL_GetRenderDriverInfo(i, &info) != 0)
+        {
+            continue;
+        }
+
+        double driverCost = timeDriver(i, window);
+
+        if(driverCost < 0)
+        {
+            printf("  %-12s could not be used. Code: %s\n", info.name, SDL_GetError());
+        }
+        else
+        {
+            printf("  %-12s %.3f ms per frame\n", info.name, driverCost);
+            if(best < 0 || driverCost < cost)
+            {
+                best = i;
+                cost = driverCost;
+            }
+        }
+    }
+
+    if(best >= 0 && SDL_GetRenderDriverInfo(best, &info) == 0)
+    {
+        saveDriver(info.name, cost);
+    }
+
+    return best;
+}
+
 //Function to initialize the renderer
-bool init_Renderer(SDL_Renderer*& renderer, SDL_Window* window)
+bool init_Renderer(SDL_Renderer*& renderer, SDL_Window* window, const RendererOptions& options)
 {
     bool success = true;
+    double cost = -1.0;
+    const char* source = "default";
+    Uint32 flags = options.vsync ? SDL_RENDERER_PRESENTVSYNC : 0;
+
+    //Renderer modes. If the chosen driver fails, SDL's own choice is tried, then the software renderer
+    int driver = chooseDriver(window, options, cost, source);
+    if(driver < 0)
+    {
+        source = "default";
+    }
+
+    //A saved or measured choice that fails is replaced by whichever driver works, so later runs do not try it again
+    bool replaceSaved = (driver >= 0 && std::string(source) != "override");
 
-    //Renderer modes
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    renderer = SDL_CreateRenderer(window, driver, flags);
+    if(renderer == NULL && driver >= 0)
+    {
+        printf("Chosen render driver could not be created, falling back. Code: %s\n", SDL_GetError());
+        source = "fallback";
+        cost = -1.0;
+        renderer = SDL_CreateRenderer(window, -1, flags);
+    }
+    if(renderer == NULL)
+    {
+        source = "fallback";
+        cost = -1.0;
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
 
     //If renderer could not be created, a reason will be given, and the program will not continue
     if(renderer == NULL)
@@ -85,6 +321,27 @@ bool init_Renderer(SDL_Renderer*& renderer, SDL_Window* window)
     }
     else
     {
+        SDL_RendererInfo info;
+        SDL_GetRendererInfo(renderer, &info);
+
+        if(replaceSaved && std::string(source) == "fallback")
+        {
+            printf("Saving %s in place of the failed driver. Run with --renderer-bench to time the drivers again.\n", info.name);
+            saveDriver(info.name, -1.0);
+        }
+
+        //Logs which renderer is in use and what one frame of the test workload cost on it
+        if(cost < 0)
+        {
+            printf("Renderer: %s (%s), frame cost not measured, vsync %s\n", info.name, source,
+                   (info.flags & SDL_RENDERER_PRESENTVSYNC) ? "on" : "off");
+        }
+        else
+        {
+            printf("Renderer: %s (%s), %.3f ms per frame, vsync %s\n", info.name, source, cost,
+                   (info.flags & SDL_RENDERER_PRESENTVSYNC) ? "on" : "off");
+        }
+
         //Sets basic draw colors
         SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 
@@ -135,7 +392,7 @@ bool loadMedia(const char* files[], SDL_Texture* textures[], SDL_Renderer* rende
             else
             {
                 //Creates a texture from the given surface
-                textures[i] = SDL_CreateTextureFromSurface(renderer, tSurface);
+                textures[i] = createTexture(renderer, tSurface);
 
                 //If the any of the textures cannot be created, a reason will be given, and the program will not continue
                 if (textures[i] == NULL)
@@ -152,13 +409,98 @@ bool loadMedia(const char* files[], SDL_Texture* textures[], SDL_Renderer* rende
     return success;
 }
 
+//Creates a texture from a surface and counts it if successful
+SDL_Texture* createTexture(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+
+    if(texture != NULL)
+    {
+        textureCount++;
+    }
+
+    return texture;
+}
+
+//Destroys a texture and clears the pointer so it cannot be destroyed twice
+void destroyTexture(SDL_Texture*& texture)
+{
+    if(texture != NULL)
+    {
+        SDL_DestroyTexture(texture);
+        texture = NULL;
+        textureCount--;
+    }
+}
+
+int getTextureCount()
+{
+    return textureCount;
+}
+
+Resources::Resources()
+{
+    window = NULL;
+    renderer = NULL;
+    font = NULL;
+    controller = NULL;
+    haptic = NULL;
+
+    for(int i = 0; i < BUTTON_TOTAL; i++)
+    {
+        textures[i] = NULL;
+    }
+}
+
+//Textures and the font must be released before the renderer and libraries they belong to
+Resources::~Resources()
+{
+    for(int i = 0; i < BUTTON_TOTAL; i++)
+    {
+        destroyTexture(textures[i]);
+    }
+
+    if(font != NULL)
+    {
+        TTF_CloseFont(font);
+    }
+    if(controller != NULL)
+    {
+        SDL_GameControllerClose(controller);
+    }
+    if(haptic != NULL)
+    {
+        SDL_HapticClose(haptic);
+    }
+    if(renderer != NULL)
+    {
+        SDL_DestroyRenderer(renderer);
+    }
+    if(window != NULL)
+    {
+        SDL_DestroyWindow(window);
+    }
+
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+}
+
 KeepOpen::KeepOpen()
 {
-    //blank process
+    prompt = true;
 }
 //Destructor automatically called, prompting user to kill the console window
 KeepOpen::~KeepOpen()
 {
-    std::cout << "Press enter to kill program.\n";
-    std::cin.ignore();
+    if(prompt)
+    {
+        std::cout << "Press enter to kill program.\n";
+        std::cin.ignore();
+    }
+}
+
+void KeepOpen::dismiss()
+{
+    prompt = false;
 }
@@ -35,19 +35,66 @@
 #define BUTTON_13       13
 #define BUTTON_TOTAL    14
 
+//Frames drawn by each render driver when timing them at startup, and the frames before timing starts
+#define RENDER_BENCH_FRAMES     60
+#define RENDER_BENCH_WARMUP     5
+//Number of overlay sized textures drawn each frame when timing render drivers
+#define RENDER_BENCH_OVERLAYS   8
+//File in the user's preference folder that remembers which render driver was fastest
+#define RENDER_CACHE_FILE       "renderer.txt"
+
+//Settings used to choose the renderer
+struct RendererOptions
+{
+    const char* driver;     //Render driver to use instead of the fastest one, or NULL to choose automatically
+    bool benchmark;         //Time every driver again even if a choice has already been saved
+    bool vsync;             //Wait for the display to refresh when presenting
+};
+
 //Initialization for the SDL window. Also initializes SDL in general
-bool init_window(SDL_Window*&, SDL_Renderer*&, const char*, int, int, int, int, Uint32);
+bool init_window(SDL_Window*&, SDL_Renderer*&, const char*, int, int, int, int, Uint32, const RendererOptions&);
 //Initialization of the SDL surface Renderer. Requires an uninitialized renderer variable
-bool init_Renderer(SDL_Renderer*&, SDL_Window*);
+bool init_Renderer(SDL_Renderer*&, SDL_Window*, const RendererOptions&);
 //Loads all media needed for the project
 bool loadMedia(const char*[], SDL_Texture*[], SDL_Renderer*, TTF_Font*& font);
 
+//Creates and destroys textures while keeping count of how many are alive. All textures should go through these
+SDL_Texture* createTexture(SDL_Renderer*, SDL_Surface*);
+void destroyTexture(SDL_Texture*&);
+int getTextureCount();
+
+//Owns every SDL object created at startup. Everything is released in the correct order when this goes out of scope
+class Resources
+{
+public:
+    Resources();
+    ~Resources();
+
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    SDL_Texture* textures[BUTTON_TOTAL];
+    TTF_Font* font;
+    SDL_GameController* controller;
+    SDL_Haptic* haptic;
+
+private:
+    //Copying would release the same objects twice, so it is not allowed
+    Resources(const Resources&);
+    Resources& operator=(const Resources&);
+};
+
 //Class to keep the window open after running to keep polling for input
 class KeepOpen
 {
 public:
     KeepOpen();
     ~KeepOpen();
+
+    //Skips the prompt, for unattended runs where nobody is there to press enter
+    void dismiss();
+
+private:
+    bool prompt;
 };
 
 
@@ -21,17 +21,23 @@
 #include <stdlib.h>
 #include "global.h"
 #include "Text.h"
+#include "Soak.h"
+#include "Combo.h"
 
 //Screen size
 const int SCREENW = 1000;
 const int SCREENH = 750;
 
+//Milliseconds a matched combo stays on screen
+const Uint32 COMBO_DISPLAY = 1000;
+
 //String constants
 const char* title = "13 Button Controller Test";
 const char* xText_1 = "Left X";
 const char* xText_2 = "Left Y";
 const char* zText_1 = "Right X";
 const char* zText_2 = "Right Y";
+const char* comboFile = "combos.txt";
 //Filenames
 const char* files[BUTTON_TOTAL] = {"Test raw.png",
                                    "Test 1.png",
@@ -48,33 +54,97 @@ const char* files[BUTTON_TOTAL] = {"Test raw.png",
                                    "Test 12.png",
                                    "Test 13.png"};
 
-//SDL global variables. These are defined in functions from other files
-SDL_Window* window = NULL;
-SDL_Renderer* tRenderer = NULL;
-SDL_Texture* current = NULL;
-SDL_Texture* backbuffer[BUTTON_TOTAL];
-TTF_Font* font = NULL;
+//Text colors. The SDL objects themselves are owned by the Resources object in main
 SDL_Color fColor = {0, 0, 0};
-SDL_GameController* controller = NULL;
-SDL_Haptic* cHaptic = NULL;
+SDL_Color comboColor = {0xFF, 0, 0};
 
 //Created a new to_string function for backwards conpatibility
 template <class T>
 std::string to_string(T x);
-void cleanup();
 
 //Program entry point
 int main(int argc, char* argv[])
 {
-    //8 variables for overlay text
-    Overlay* X_Coord         = new Overlay();
-    Overlay* X_Text          = new Overlay();
-    Overlay* Y_Coord         = new Overlay();
-    Overlay* Y_Text          = new Overlay();
-    Overlay* Z_Pos_Coord     = new Overlay();
-    Overlay* Z_Pos_Text      = new Overlay();
-    Overlay* Z_Neg_Coord     = new Overlay();
-    Overlay* Z_Neg_Text      = new Overlay();
+    //Object to keep console window open. Declared first so it runs after everything else has been released
+    KeepOpen ko;
+
+    //Owns the window, renderer, images, font and controller, and releases them when main returns
+    Resources res;
+
+    //Shorter names for the objects owned by res. current only points at one of the backbuffer textures
+    SDL_Texture** backbuffer = res.textures;
+    SDL_Texture* current = NULL;
+
+    //8 variables for overlay text. Declared after res so their textures are destroyed before the renderer
+    Overlay X_Coord;
+    Overlay X_Text;
+    Overlay Y_Coord;
+    Overlay Y_Text;
+    Overlay Z_Pos_Coord;
+    Overlay Z_Pos_Text;
+    Overlay Z_Neg_Coord;
+    Overlay Z_Neg_Text;
+    Overlay Combo_Text;
+
+    //Soak mode. Only does anything once begin is called, and prints its log when main returns
+    Soak soak;
+
+    //Combo detection, and the time the last match was made
+    ComboEngine combos;
+    Uint32 comboTime = 0;
+
+    //Soak mode is enabled with --soak, optionally followed by a duration in seconds
+    bool soakMode = false;
+    Uint32 soakSeconds = 0;
+
+    //The fastest render driver is chosen automatically unless --renderer is given
+    RendererOptions rOptions = {NULL, false, true};
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::string(argv[i]) == "--soak")
+        {
+            soakMode = true;
+            if(i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                soakSeconds = (Uint32)strtoul(argv[++i], NULL, 10);
+            }
+        }
+        //Uses the named render driver, such as software or opengl, instead of the fastest one
+        else if(std::string(argv[i]) == "--renderer")
+        {
+            if(i + 1 >= argc || argv[i + 1][0] == '-')
+            {
+                printf("Usage: --renderer <name>, where name is a render driver such as software or opengl\n");
+                return 1;
+            }
+            rOptions.driver = argv[++i];
+        }
+        //Times every render driver again instead of using the saved choice
+        else if(std::string(argv[i]) == "--renderer-bench")
+        {
+            rOptions.benchmark = true;
+        }
+        else if(std::string(argv[i]) == "--no-vsync")
+        {
+            rOptions.vsync = false;
+        }
+        //Times the combo engine and exits without opening a window or waiting for enter
+        else if(std::string(argv[i]) == "--combo-bench")
+        {
+            ko.dismiss();
+            benchmarkCombos();
+            return 0;
+        }
+    }
+
+    //Soak runs are unattended, so the program must be able to exit without anyone pressing enter.
+    //Vsync is turned off so the frame times in the soak log show the real cost of each frame, not the wait for the display
+    if(soakMode)
+    {
+        ko.dismiss();
+        rOptions.vsync = false;
+    }
 
     //Variables for to_string, kept separate to avoid messing up which goes where
     Sint16 x = 0;
@@ -88,11 +158,8 @@ int main(int argc, char* argv[])
     std::string rx_Str;
     std::string ry_Str;
 
-    //Object to keep console window open
-    KeepOpen ko;
-
     //Initializes window. If this fails, a reason will be given from within the function
-    if(!init_window(window, tRenderer, title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREENW, SCREENH, SDL_WINDOW_SHOWN))
+    if(!init_window(res.window, res.renderer, title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREENW, SCREENH, SDL_WINDOW_SHOWN, rOptions))
     {
         printf("Window could not be initialized. See above for specific errors.\n");
         return 1;
@@ -100,17 +167,20 @@ int main(int argc, char* argv[])
     else
     {
         //Loads media from file name array. If this fails, a reason will be given from within the function
-        if(!loadMedia(files, backbuffer, tRenderer, font))
+        if(!loadMedia(files, res.textures, res.renderer, res.font))
         {
             printf("Unable to load media. See above for specific errors.\n");
         }
         // Creates the static textboxes for labeling joystick output
         else
         {
-            X_Text->createFromText(xText_1, fColor, font, tRenderer);
-            Y_Text->createFromText(xText_2, fColor, font, tRenderer);
-            Z_Pos_Text->createFromText(zText_1, fColor, font, tRenderer);
-            Z_Neg_Text->createFromText(zText_2, fColor, font, tRenderer);
+            X_Text.createFromText(xText_1, fColor, res.font, res.renderer);
+            Y_Text.createFromText(xText_2, fColor, res.font, res.renderer);
+            Z_Pos_Text.createFromText(zText_1, fColor, res.font, res.renderer);
+            Z_Neg_Text.createFromText(zText_2, fColor, res.font, res.renderer);
+
+            //Combos are optional, so the program continues if the file cannot be loaded
+            combos.load(comboFile);
 
             //Workaround for SDL not having a similar function for gamepads
             if(SDL_NumJoysticks() < 1)
@@ -123,10 +193,10 @@ int main(int argc, char* argv[])
                 //Displays the number of detected, connected controllers and haptic (Force Feedback) devices
                 printf("%d: Number of connected controllers\n%d: Number of haptic devices\n", SDL_NumJoysticks(), SDL_NumHaptics());
                 //Initializes the controller object
-                controller = SDL_GameControllerOpen(0);
+                res.controller = SDL_GameControllerOpen(0);
 
                 //If controller is not initialized, a code is given, and the program closes
-                if (controller == NULL)
+                if (res.controller == NULL)
                 {
                     printf("Error opening controller. Code: %s\n", SDL_GetError());
                     return 2;
@@ -141,10 +211,31 @@ int main(int argc, char* argv[])
             //Sets the default screen
             current = backbuffer[BUTTON_DEFAULT];
 
+            if(soakMode)
+            {
+                soak.begin(soakSeconds);
+            }
+            Uint64 frameStart = SDL_GetPerformanceCounter();
+
             while(!done)
             {
+                soak.injectInput();
+
+                //Number of events handled this frame, used by soak mode to spot a backlog
+                int handled = 0;
+
                 while(SDL_PollEvent(&e)!= 0)
                 {
+                    handled++;
+
+                    //Every event is checked for combos before it is handled below
+                    int match = combos.processEvent(e);
+                    if(match >= 0)
+                    {
+                        Combo_Text.createFromText(combos.getName(match), comboColor, res.font, res.renderer);
+                        comboTime = SDL_GetTicks();
+                    }
+
                     //Generic events for killing the program window
                     if(e.type == SDL_QUIT)
                     {
@@ -168,32 +259,33 @@ int main(int argc, char* argv[])
                             {
                                 //Each of these case statements takes which input is being detected, creates a string from it, and
                                 //initializes the corresponding Overlay object with that value. Deadzones are intentionally omitted
-                                //as the purpose of this program is to test raw controller output
+                                //as the purpose of this program is to test raw controller output. The value is read from the event
+                                //itself so that synthetic events from soak mode are handled the same way as real ones
                             case SDL_CONTROLLER_AXIS_LEFTX:
-                                x = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTX);
+                                x = e.caxis.value;
                                 x_Str = to_string(x);
-                                X_Coord->createFromText(x_Str.c_str(), fColor, font, tRenderer);
+                                X_Coord.createFromText(x_Str.c_str(), fColor, res.font, res.renderer);
                                // printf("%s = Left X axis report\n", x_Str.c_str());
                                 break;
 
                             case SDL_CONTROLLER_AXIS_LEFTY:
-                                y = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTY);
+                                y = e.caxis.value;
                                 y_Str = to_string(y);
-                                Y_Coord->createFromText(y_Str.c_str(), fColor, font, tRenderer);
+                                Y_Coord.createFromText(y_Str.c_str(), fColor, res.font, res.renderer);
                                 //printf("%s = Left Y axis report\n", y_Str.c_str());
                                 break;
 
                             case SDL_CONTROLLER_AXIS_RIGHTX:
-                                rx = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_RIGHTX);
+                                rx = e.caxis.value;
                                 rx_Str = to_string(rx);
-                                Z_Pos_Coord->createFromText(rx_Str.c_str(), fColor, font, tRenderer);
+                                Z_Pos_Coord.createFromText(rx_Str.c_str(), fColor, res.font, res.renderer);
                                 //printf("%s = Right X Axis Report\n", rx_Str.c_str());
                                 break;
 
                             case SDL_CONTROLLER_AXIS_RIGHTY:
-                                ry = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_RIGHTY);
+                                ry = e.caxis.value;
                                 ry_Str = to_string(ry);
-                                Z_Neg_Coord->createFromText(ry_Str.c_str(), fColor, font, tRenderer);
+                                Z_Neg_Coord.createFromText(ry_Str.c_str(), fColor, res.font, res.renderer);
                                 //printf("%s = Right Y Axis Report\n", ry_Str.c_str());
                                 break;
 
@@ -267,25 +359,39 @@ int main(int argc, char* argv[])
 
                 }
                 //Drawing functions on screen. This uses the Painter's Algorithm
-                SDL_RenderClear(tRenderer);
-                SDL_RenderCopy(tRenderer, current, NULL, NULL);
-                X_Text->render(50, 100, tRenderer);
+                SDL_RenderClear(res.renderer);
+                SDL_RenderCopy(res.renderer, current, NULL, NULL);
+                X_Text.render(50, 100, res.renderer);
                 //Each Overlay object marked as Coord inherits its position from the static box above it
-                X_Coord->render(50, (100 + X_Text->getHeight() + 10), tRenderer);
-                Y_Text->render(50, (250), tRenderer);
-                Y_Coord->render(50, (250 + Y_Text->getHeight() + 10), tRenderer);
-                Z_Pos_Text->render((SCREENW - (Z_Pos_Text->getWidth() + 50)), 100, tRenderer);
-                Z_Pos_Coord->render((SCREENW - (Z_Pos_Text->getWidth() + 50)), (100 + Z_Pos_Text->getHeight() + 10), tRenderer);
-                Z_Neg_Text->render((SCREENW - (Z_Neg_Text->getWidth() + 50)), 250, tRenderer);
-                Z_Neg_Coord->render((SCREENW - (Z_Neg_Text->getWidth() + 50)), (250 + (Z_Neg_Text->getHeight() + 10)), tRenderer);
+                X_Coord.render(50, (100 + X_Text.getHeight() + 10), res.renderer);
+                Y_Text.render(50, (250), res.renderer);
+                Y_Coord.render(50, (250 + Y_Text.getHeight() + 10), res.renderer);
+                Z_Pos_Text.render((SCREENW - (Z_Pos_Text.getWidth() + 50)), 100, res.renderer);
+                Z_Pos_Coord.render((SCREENW - (Z_Pos_Text.getWidth() + 50)), (100 + Z_Pos_Text.getHeight() + 10), res.renderer);
+                Z_Neg_Text.render((SCREENW - (Z_Neg_Text.getWidth() + 50)), 250, res.renderer);
+                Z_Neg_Coord.render((SCREENW - (Z_Neg_Text.getWidth() + 50)), (250 + (Z_Neg_Text.getHeight() + 10)), res.renderer);
+                //The last matched combo is shown centered near the bottom of the screen for a short time
+                if(comboTime != 0 && SDL_GetTicks() - comboTime < COMBO_DISPLAY)
+                {
+                    Combo_Text.render(((SCREENW - Combo_Text.getWidth()) / 2), (SCREENH - Combo_Text.getHeight() - 50), res.renderer);
+                }
                 //Update the screen
-                SDL_RenderPresent(tRenderer);
+                SDL_RenderPresent(res.renderer);
+
+                //Frame time covers event handling, drawing and presenting
+                Uint64 frameEnd = SDL_GetPerformanceCounter();
+                soak.update((double)(frameEnd - frameStart) * 1000.0 / SDL_GetPerformanceFrequency(), handled);
+                if(soak.finished())
+                {
+                    done = true;
+                }
+                frameStart = frameEnd;
             }
-            //Releases all unreleased objects from memory before ending the program
-            cleanup();
         }
     }
 
+    //Everything created above is released by the destructors of the overlays and res, in that order
+
     return 0;
 }
 template <class T>
@@ -296,21 +402,3 @@ std::string to_string(T x)
     return oss.str();
 
 }
-
-void cleanup()
-{
-    for (int i = 0; i < BUTTON_TOTAL; i++)
-    {
-        SDL_DestroyTexture(backbuffer[i]);
-    }
-    SDL_DestroyTexture(current);
-    SDL_DestroyRenderer(tRenderer);
-    SDL_DestroyWindow(window);
-
-    SDL_GameControllerClose(controller);
-    SDL_HapticClose(cHaptic);
-
-    IMG_Quit();
-    SDL_Quit();
-    TTF_Quit();
-}